@@ -34,36 +34,60 @@
 #include "Arduino.h"
 #include "Wire.h"
 #include "Rtc_Pcf8593.h"
+#include "Rtc_Pcf8593_Trace.h"
+
+#if !RTCC_FEATURE_TRACE
+#define RtccWire Wire
+#endif
 
 Rtc_Pcf8593::Rtc_Pcf8593(void)
 {
-    Wire.begin();
-    Rtcc_Addr = RTCC_R>>1;
+    RtccWire.begin();
+#if RTCC_FEATURE_ALARM
+    alarm_valid = 0;		//alarm vars unknown until getAlarm()
+#endif
+}
+
+#if RTCC_FEATURE_TRACE
+void Rtc_Pcf8593::setTrace(Rtc_Pcf8593_Trace *trace)
+{
+    RtccWire.setTrace(trace);
 }
+#endif
 
 void Rtc_Pcf8593::initClock()
 {
-  Wire.beginTransmission(Rtcc_Addr);    // Issue I2C start signal
-  Wire.write((byte)0x0);     // start address
-
-  Wire.write((byte)0x04);    //control/status1, reset value 0x04 
-  Wire.write((byte)0x01);    //set hundredth seconds
-  Wire.write((byte)0x01);    //set seconds
-  Wire.write((byte)0x01);    //set minutes
-  Wire.write((byte)0x01);    //set hour
-  Wire.write((byte)0x01);    //set day, set year
-  Wire.write((byte)0x01);    //set weekday, set month
-  Wire.write((byte)0x01);    //set timer (year) to 1
-  Wire.write((byte)0x0);    //set alarm control/status2
-  Wire.write((byte)0x0);    //hundredth seconds alarm value reset to 00
-  Wire.write((byte)0x0);    //seconds alarm value reset to 00
-  Wire.write((byte)0x0);    //minute alarm value reset to 00
-  Wire.write((byte)0x0);    //hour alarm value reset to 00
-  Wire.write((byte)0x0);    //day alarm value reset to 00
-  Wire.write((byte)0x0);    //month alarm value reset to 00
-  Wire.write((byte)0x0);    //alarm timer off
-  Wire.endTransmission();
+  RtccWire.beginTransmission(RTCC_ADDR);    // Issue I2C start signal
+  RtccWire.write((byte)0x0);     // start address
+
+  RtccWire.write((byte)0x04);    //control/status1, reset value 0x04 
+  RtccWire.write((byte)0x01);    //set hundredth seconds
+  RtccWire.write((byte)0x01);    //set seconds
+  RtccWire.write((byte)0x01);    //set minutes
+  RtccWire.write((byte)0x01);    //set hour
+  RtccWire.write((byte)0x01);    //set day, set year
+  RtccWire.write((byte)0x01);    //set weekday, set month
+  RtccWire.write((byte)0x01);    //set timer (year) to 1
+  RtccWire.write((byte)0x0);    //set alarm control/status2
+  RtccWire.write((byte)0x0);    //hundredth seconds alarm value reset to 00
+  RtccWire.write((byte)0x0);    //seconds alarm value reset to 00
+  RtccWire.write((byte)0x0);    //minute alarm value reset to 00
+  RtccWire.write((byte)0x0);    //hour alarm value reset to 00
+  RtccWire.write((byte)0x0);    //day alarm value reset to 00
+  RtccWire.write((byte)0x0);    //month alarm value reset to 00
+  RtccWire.write((byte)0x0);    //alarm timer off
+  RtccWire.endTransmission();
 
+  status1 = 0x04;
+  status2 = 0x00;
+#if RTCC_FEATURE_ALARM
+  alarm_second = 0;          //alarm vars now known without a read
+  alarm_minute = 0;
+  alarm_hour = 0;
+  alarm_day = 0;
+  alarm_month_reg = 0;
+  alarm_valid = 1;
+#endif
 }
 
 /* Private internal functions, but useful to look at if you need a similar func. */
@@ -80,15 +104,15 @@ byte Rtc_Pcf8593::bcdToDec(byte val)
 
 void Rtc_Pcf8593::clearStatus()
 {
-  Wire.beginTransmission(Rtcc_Addr);      // Issue I2C start signal
-  Wire.write((byte)0x0);
-  Wire.write((byte)0x04);                 //control/status1
-  Wire.endTransmission();
+  RtccWire.beginTransmission(RTCC_ADDR);      // Issue I2C start signal
+  RtccWire.write((byte)0x0);
+  RtccWire.write((byte)0x04);                 //control/status1
+  RtccWire.endTransmission();
   
-  Wire.beginTransmission(Rtcc_Addr);      // Issue I2C start signal
-  Wire.write((byte)RTCC_STAT2_ADDR);
-  Wire.write((byte)0x0);                  //alarm control/status2
-  Wire.endTransmission();
+  RtccWire.beginTransmission(RTCC_ADDR);      // Issue I2C start signal
+  RtccWire.write((byte)RTCC_STAT2_ADDR);
+  RtccWire.write((byte)0x0);                  //alarm control/status2
+  RtccWire.endTransmission();
 
   status1 = 0x04;
   status2 = 0x00;
@@ -96,13 +120,13 @@ void Rtc_Pcf8593::clearStatus()
 
 void Rtc_Pcf8593::setTime(byte hour, byte minute, byte sec)
 {
-  Wire.beginTransmission(Rtcc_Addr);     // Issue I2C start signal
-  Wire.write((byte)RTCC_SEC_ADDR);       // send addr low byte, req'd
+  RtccWire.beginTransmission(RTCC_ADDR);     // Issue I2C start signal
+  RtccWire.write((byte)RTCC_SEC_ADDR);       // send addr low byte, req'd
 
-  Wire.write((byte)decToBcd(sec));       //set seconds
-  Wire.write((byte)decToBcd(minute));    //set minutes
-  Wire.write((byte)decToBcd(hour));      //set hour
-  Wire.endTransmission();
+  RtccWire.write((byte)decToBcd(sec));       //set seconds
+  RtccWire.write((byte)decToBcd(minute));    //set minutes
+  RtccWire.write((byte)decToBcd(hour));      //set hour
+  RtccWire.endTransmission();
 }
 
 void Rtc_Pcf8593::setDate(byte day, byte weekday, byte mon, byte century, byte year)
@@ -112,22 +136,23 @@ void Rtc_Pcf8593::setDate(byte day, byte weekday, byte mon, byte century, byte y
        weekday is month 3 high bit
         */
 
-    Wire.beginTransmission(Rtcc_Addr);       // Issue I2C start signal
-    Wire.write((byte)RTCC_DAY_ADDR);
-    Wire.write((byte)decToBcd(day));         //set day, year to 0
+    RtccWire.beginTransmission(RTCC_ADDR);       // Issue I2C start signal
+    RtccWire.write((byte)RTCC_DAY_ADDR);
+    RtccWire.write((byte)decToBcd(day));         //set day, year to 0
     mon = decToBcd(mon);
     weekday = decToBcd(weekday);
     weekday = weekday << 5;
     mon = mon | weekday;                     //compine weekday to month
-    Wire.write((byte)mon);                   //set month and weekday
-    Wire.endTransmission();
+    RtccWire.write((byte)mon);                   //set month and weekday
+    RtccWire.endTransmission();
     
-    Wire.beginTransmission(Rtcc_Addr);       // Issue I2C start signal
-    Wire.write((byte)RTCC_YEAR_ADDR);
-    Wire.write((byte)decToBcd(year));        //set year
-    Wire.endTransmission();
+    RtccWire.beginTransmission(RTCC_ADDR);       // Issue I2C start signal
+    RtccWire.write((byte)RTCC_YEAR_ADDR);
+    RtccWire.write((byte)decToBcd(year));        //set year
+    RtccWire.endTransmission();
 }
 
+#if RTCC_FEATURE_ALARM
 /* enable alarm interrupt
  * whenever the clock matches these values an int will
  * be sent out pin 7 of the Pcf8593 chip
@@ -142,18 +167,18 @@ void Rtc_Pcf8593::enableAlarm()
     status2 |= RTCC_ALARM_AIE;
 
     //clear alarm flag
-    Wire.beginTransmission(Rtcc_Addr);  // Issue I2C start signal
-    Wire.write((byte)RTCC_STAT1_ADDR);
-    Wire.write((byte)status1);		//set status1
-    Wire.endTransmission();
+    RtccWire.beginTransmission(RTCC_ADDR);  // Issue I2C start signal
+    RtccWire.write((byte)RTCC_STAT1_ADDR);
+    RtccWire.write((byte)status1);		//set status1
+    RtccWire.endTransmission();
     
     //enable the interrupt
-    Wire.beginTransmission(Rtcc_Addr);  // Issue I2C start signal
-    Wire.write((byte)RTCC_STAT2_ADDR);
-    Wire.write((byte)status2);		//set status2
-    Wire.endTransmission();
+    RtccWire.beginTransmission(RTCC_ADDR);  // Issue I2C start signal
+    RtccWire.write((byte)RTCC_STAT2_ADDR);
+    RtccWire.write((byte)status2);		//set status2
+    RtccWire.endTransmission();
 }
-
+#endif
 
 /*
 * Read status1 byte
@@ -161,12 +186,12 @@ void Rtc_Pcf8593::enableAlarm()
 byte Rtc_Pcf8593::readStatus1()
 {
     /* set the start byte of the status1 data */
-    Wire.beginTransmission(Rtcc_Addr);
-    Wire.write((byte)RTCC_STAT1_ADDR);
-    Wire.endTransmission();
+    RtccWire.beginTransmission(RTCC_ADDR);
+    RtccWire.write((byte)RTCC_STAT1_ADDR);
+    RtccWire.endTransmission();
 
-    Wire.requestFrom(Rtcc_Addr, 1); //request 1 bytes
-    status1 = Wire.read();
+    RtccWire.requestFrom(RTCC_ADDR, 1); //request 1 bytes
+    status1 = RtccWire.read();
     return status1;
 }
 
@@ -177,15 +202,16 @@ byte Rtc_Pcf8593::readStatus1()
 byte Rtc_Pcf8593::readStatus2()
 {
     /* set the start byte of the status2 data */
-    Wire.beginTransmission(Rtcc_Addr);
-    Wire.write((byte)RTCC_STAT2_ADDR);
-    Wire.endTransmission();
+    RtccWire.beginTransmission(RTCC_ADDR);
+    RtccWire.write((byte)RTCC_STAT2_ADDR);
+    RtccWire.endTransmission();
 
-    Wire.requestFrom(Rtcc_Addr, 1); //request 1 bytes
-    status2 = Wire.read();
+    RtccWire.requestFrom(RTCC_ADDR, 1); //request 1 bytes
+    status2 = RtccWire.read();
     return status2;
 }
 
+#if RTCC_FEATURE_ALARM
 /*
 * Returns true if AIE is on
 *
@@ -241,13 +267,17 @@ void Rtc_Pcf8593::setAlarmTime(byte hour, byte min, byte sec)
     }
 
 
-    Wire.beginTransmission(Rtcc_Addr);    // Issue I2C start signal
-    Wire.write((byte)RTCC_ALRM_HUND_SEC_ADDR);
-    Wire.write((byte)0x0);                //hunred second alarm value to 00
-    Wire.write((byte)sec);                //second alarm value reset to 00
-    Wire.write((byte)min);                //minute alarm value reset to 00
-    Wire.write((byte)hour);               //hour alarm value reset to 00
-    Wire.endTransmission();
+    RtccWire.beginTransmission(RTCC_ADDR);    // Issue I2C start signal
+    RtccWire.write((byte)RTCC_ALRM_HUND_SEC_ADDR);
+    RtccWire.write((byte)0x0);                //hunred second alarm value to 00
+    RtccWire.write((byte)sec);                //second alarm value reset to 00
+    RtccWire.write((byte)min);                //minute alarm value reset to 00
+    RtccWire.write((byte)hour);               //hour alarm value reset to 00
+    RtccWire.endTransmission();
+
+    alarm_second = bcdToDec(sec);         //keep local vars in step
+    alarm_minute = bcdToDec(min);
+    alarm_hour = bcdToDec(hour);
 }
 
 
@@ -272,11 +302,14 @@ void Rtc_Pcf8593::setAlarmDate(byte day, byte month)
     }
 
 
-    Wire.beginTransmission(Rtcc_Addr);    // Issue I2C start signal
-    Wire.write((byte)RTCC_ALRM_DAY_ADDR);
-    Wire.write((byte)day);                //day alarm value
-    Wire.write((byte)month);              //month alarm value
-    Wire.endTransmission();
+    RtccWire.beginTransmission(RTCC_ADDR);    // Issue I2C start signal
+    RtccWire.write((byte)RTCC_ALRM_DAY_ADDR);
+    RtccWire.write((byte)day);                //day alarm value
+    RtccWire.write((byte)month);              //month alarm value
+    RtccWire.endTransmission();
+
+    alarm_day = bcdToDec(day);            //keep local vars in step
+    alarm_month_reg = month;
 }
 
 
@@ -300,10 +333,12 @@ void Rtc_Pcf8593::setAlarmWeekday(byte weekday)
     */
 
 
-    Wire.beginTransmission(Rtcc_Addr);    	// Issue I2C start signal
-    Wire.write((byte)RTCC_ALRM_MONTH_ADDR);
-    Wire.write((byte)weekday);                  //weekday alarm value reset to 00
-    Wire.endTransmission();
+    RtccWire.beginTransmission(RTCC_ADDR);    	// Issue I2C start signal
+    RtccWire.write((byte)RTCC_ALRM_MONTH_ADDR);
+    RtccWire.write((byte)weekday);                  //weekday alarm value reset to 00
+    RtccWire.endTransmission();
+
+    alarm_month_reg = weekday;                  //keep local vars in step
 }
 
 
@@ -315,10 +350,10 @@ void Rtc_Pcf8593::setAlarmMode(byte mode)
     status2 &= ~0x30;		//clear old value
     status2 |= mode;		//add new value
 
-    Wire.beginTransmission(Rtcc_Addr);    // Issue I2C start signal
-    Wire.write((byte)RTCC_STAT2_ADDR);
-    Wire.write((byte)status2);            //set alarm mode
-    Wire.endTransmission();
+    RtccWire.beginTransmission(RTCC_ADDR);    // Issue I2C start signal
+    RtccWire.write((byte)RTCC_STAT2_ADDR);
+    RtccWire.write((byte)status2);            //set alarm mode
+    RtccWire.endTransmission();
     
     if (mode == 0x00){		//enable or disable alarm
         Rtc_Pcf8593::clearAlarm();
@@ -334,21 +369,134 @@ void Rtc_Pcf8593::getAlarm()
 {
   
     // set the start byte of the alarm data
-    Wire.beginTransmission(Rtcc_Addr);
-    Wire.write((byte)RTCC_STAT2_ADDR);
-    Wire.endTransmission();
+    RtccWire.beginTransmission(RTCC_ADDR);
+    RtccWire.write((byte)RTCC_STAT2_ADDR);
+    RtccWire.endTransmission();
 
-    Wire.requestFrom(Rtcc_Addr, 7);		//request 6 bytes
-    status2 = Wire.read();
-    alarm_second = Wire.read();			//alarm hunred seconds is ignored
-    alarm_second = bcdToDec(Wire.read());
-    alarm_minute = bcdToDec(Wire.read());
-    alarm_hour = bcdToDec(Wire.read());
-    alarm_day = bcdToDec(Wire.read());
-    alarm_weekday = Wire.read();		//alarm month and weekday are in the same place
-    alarm_month = bcdToDec(alarm_weekday);
+    RtccWire.requestFrom(RTCC_ADDR, 7);		//request 7 bytes
+    status2 = RtccWire.read();
+    RtccWire.read();				//alarm hunred seconds is ignored
+    alarm_second = bcdToDec(RtccWire.read() & 0x7f);
+    alarm_minute = bcdToDec(RtccWire.read() & 0x7f);
+    alarm_hour = bcdToDec(RtccWire.read() & 0x3f);
+    alarm_day = bcdToDec(RtccWire.read() & 0x3f);
+    alarm_month_reg = RtccWire.read();		//alarm month and weekday are in the same place
+    alarm_valid = 1;
 }
 
+/**
+* Get the alarm, read from the chip only the first time.
+* The set methods keep it up to date after that.
+*/
+void Rtc_Pcf8593::getAlarmSnapshot(Rtcc_Alarm &alarm)
+{
+    if (!alarm_valid){
+        getAlarm();
+    }
+    if (status2 & RTCC_ALARM_AIE){		//no interrupt, no wake up
+        alarm.mode = status2 & 0x30;
+    }else{
+        alarm.mode = RTCC_ALARM_DISABLED;
+    }
+    alarm.second = alarm_second;
+    alarm.minute = alarm_minute;
+    alarm.hour = alarm_hour;
+    alarm.day = alarm_day;
+    alarm.month = getAlarmMonth();
+    alarm.weekdays = getAlarmWeekday();
+}
+
+/**
+* Next time the alarm fires after the last read time,
+* no bus access once the alarm has been read.
+*/
+boolean Rtc_Pcf8593::nextAlarm(Rtcc_Time &next)
+{
+    Rtcc_Time now;
+    Rtcc_Alarm alarm;
+
+    getSnapshot(now);
+    getAlarmSnapshot(alarm);
+    return nextAlarm(now, alarm, next);
+}
+
+/**
+* Next time alarm fires strictly after now.
+* Returns false if it never fires (disabled, no weekdays, no such date).
+*/
+boolean Rtc_Pcf8593::nextAlarm(const Rtcc_Time &now, const Rtcc_Alarm &alarm, Rtcc_Time &next)
+{
+    next = now;
+    next.hund_sec = 0;
+    next.hour = alarm.hour;
+    next.minute = alarm.minute;
+    next.second = alarm.second;
+
+    //alarm matches at hundredths 00, so an equal time has already fired
+    unsigned long alarm_secs = (alarm.hour * 60UL + alarm.minute) * 60 + alarm.second;
+    unsigned long now_secs = (now.hour * 60UL + now.minute) * 60 + now.second;
+    boolean later_today = alarm_secs > now_secs;
+
+    switch (alarm.mode) {
+        case RTCC_ALARM_DAILY:
+            if (!later_today){
+                addDay(next);
+            }
+            return true;
+        case RTCC_ALARM_WEEKDAY:
+            if ((alarm.weekdays & 0x7f) == 0){
+                return false;
+            }
+            if (!later_today){
+                addDay(next);
+            }
+            while (!(alarm.weekdays & (1 << next.weekday))){
+                addDay(next);
+            }
+            return true;
+        case RTCC_ALARM_DATED:
+            if (alarm.month < 1 || alarm.month > 12 || alarm.day < 1){
+                return false;
+            }
+            //29th of February can be up to 8 years ahead
+            for (byte i = 0; i <= 8; i++) {
+                byte year = now.year + i;	//may pass 99, see dayNumber
+                if (alarm.day > daysInMonth(alarm.month, year)){
+                    continue;
+                }
+                if (i == 0 && (alarm.month < now.month || (alarm.month == now.month &&
+                        (alarm.day < now.day || (alarm.day == now.day && !later_today))))){
+                    continue;			//already passed this year
+                }
+                next.day = alarm.day;
+                next.month = alarm.month;
+                next.year = year % 100;
+                next.weekday = (now.weekday + dayNumber(alarm.day, alarm.month, year) -
+                        dayNumber(now.day, now.month, now.year)) % 7;
+                return true;
+            }
+            return false;
+        default:
+            return false;
+    }
+}
+
+/* step t to the same time on the next day */
+void Rtc_Pcf8593::addDay(Rtcc_Time &t)
+{
+    t.weekday = (t.weekday + 1) % 7;
+    t.day++;
+    if (t.day > daysInMonth(t.month, t.year)){
+        t.day = 1;
+        t.month++;
+        if (t.month > 12){
+            t.month = 1;
+            t.year = (t.year + 1) % 100;
+        }
+    }
+}
+
+
 /**
 * Reset the alarm leaving interrupt unchanged
 */
@@ -357,10 +505,10 @@ void Rtc_Pcf8593::resetAlarm()
     Rtc_Pcf8593::readStatus1();
     //set status1 AF val to zero to reset alarm
     status1 &= ~RTCC_ALARM_AF;
-    Wire.beginTransmission(Rtcc_Addr);
-    Wire.write((byte)RTCC_STAT1_ADDR);
-    Wire.write((byte)status1);		//set status1
-    Wire.endTransmission();
+    RtccWire.beginTransmission(RTCC_ADDR);
+    RtccWire.write((byte)RTCC_STAT1_ADDR);
+    RtccWire.write((byte)status1);		//set status1
+    RtccWire.endTransmission();
 }
 
 /**
@@ -375,84 +523,120 @@ void Rtc_Pcf8593::clearAlarm()
     //turn off the interrupt
     status2 &= ~RTCC_ALARM_AIE;
 
-    Wire.beginTransmission(Rtcc_Addr);
-    Wire.write((byte)RTCC_STAT1_ADDR);
-    Wire.write((byte)status1);		//set status1
-    Wire.endTransmission();
+    RtccWire.beginTransmission(RTCC_ADDR);
+    RtccWire.write((byte)RTCC_STAT1_ADDR);
+    RtccWire.write((byte)status1);		//set status1
+    RtccWire.endTransmission();
 
-    Wire.beginTransmission(Rtcc_Addr);
-    Wire.write((byte)RTCC_STAT2_ADDR);
-    Wire.write((byte)status2);		//set status2
-    Wire.endTransmission();
+    RtccWire.beginTransmission(RTCC_ADDR);
+    RtccWire.write((byte)RTCC_STAT2_ADDR);
+    RtccWire.write((byte)status2);		//set status2
+    RtccWire.endTransmission();
 }
+#endif
 
 void Rtc_Pcf8593::getDate()
 {
     /* set the start byte of the date data */
-    Wire.beginTransmission(Rtcc_Addr);
-    Wire.write((byte)RTCC_DAY_ADDR);
-    Wire.endTransmission();
+    RtccWire.beginTransmission(RTCC_ADDR);
+    RtccWire.write((byte)RTCC_DAY_ADDR);
+    RtccWire.endTransmission();
 
-    Wire.requestFrom(Rtcc_Addr, 2); //request 2 bytes
-    
-    day = Wire.read();
+    RtccWire.requestFrom(RTCC_ADDR, 2); //request 2 bytes
+    byte day_reg = RtccWire.read();
+    byte month_reg = RtccWire.read();
+
+    RtccWire.beginTransmission(RTCC_ADDR);
+    RtccWire.write((byte)RTCC_YEAR_ADDR);
+    RtccWire.endTransmission();
+
+    RtccWire.requestFrom(RTCC_ADDR, 1);	//request 1 bytes
+    storeDate(day_reg, month_reg, RtccWire.read());
+}
+
+/*
+* Decode raw day/month/year registers to local vars
+* and roll the year if the chip counted over it
+*/
+void Rtc_Pcf8593::storeDate(byte day_reg, byte month_reg, byte year_reg)
+{
     //get raw day data byte and (rolling) year with it.
-    byte yearsPassed = day & RTCC_YEAR_MASK;
+    byte yearsPassed = day_reg & RTCC_YEAR_MASK;
     yearsPassed = yearsPassed >> 6;
     yearsPassed = bcdToDec(yearsPassed);
 
+    //decode before storing, packed vars are too narrow for bcd
     //0x3f = 0b00111111
-    day = day & 0x3f;
-    day = bcdToDec(day);
-        
-    month = Wire.read();
+    day = bcdToDec(day_reg & 0x3f);
+
     //0xE0 = 0b11100000
-    weekday = month & 0xE0;
-    weekday = weekday >> 5;
-    weekday = bcdToDec(weekday);
+    weekday = (month_reg >> 5) & 0x07;
     //0x1f = 0b00011111
-    month = month & 0x1f;
-    month = bcdToDec(month);
-    
-    Wire.beginTransmission(Rtcc_Addr);
-    Wire.write((byte)RTCC_YEAR_ADDR);
-    Wire.endTransmission();
+    month = bcdToDec(month_reg & 0x1f);
+
+    year = bcdToDec(year_reg);
 
-    Wire.requestFrom(Rtcc_Addr, 1);	//request 1 bytes
-    year = bcdToDec(Wire.read());
-    
     if (yearsPassed > 0){		//If year changed
       year = year +yearsPassed;		//Add passed year(s) to current year
-      Wire.beginTransmission(Rtcc_Addr);    // Issue I2C start signal
-      Wire.write((byte)RTCC_YEAR_ADDR);
-      Wire.write((byte)decToBcd(year));     //set new year
-      Wire.endTransmission();
-      
-      Wire.beginTransmission(Rtcc_Addr);    // Issue I2C start signal
-      Wire.write((byte)RTCC_DAY_ADDR);
-      Wire.write((byte)day);            //set day, (rolling) year to 0
-      Wire.endTransmission();
+      RtccWire.beginTransmission(RTCC_ADDR);    // Issue I2C start signal
+      RtccWire.write((byte)RTCC_YEAR_ADDR);
+      RtccWire.write((byte)decToBcd(year));     //set new year
+      RtccWire.endTransmission();
+
+      RtccWire.beginTransmission(RTCC_ADDR);    // Issue I2C start signal
+      RtccWire.write((byte)RTCC_DAY_ADDR);
+      RtccWire.write((byte)(day_reg & 0x3f));   //set day, (rolling) year to 0
+      RtccWire.endTransmission();
     }
 }
 
 void Rtc_Pcf8593::getTime()
 {
     /* set the start byte , get the status1 byte */
-    Wire.beginTransmission(Rtcc_Addr);
-    Wire.write((byte)RTCC_STAT1_ADDR);
-    Wire.endTransmission();
+    RtccWire.beginTransmission(RTCC_ADDR);
+    RtccWire.write((byte)RTCC_STAT1_ADDR);
+    RtccWire.endTransmission();
 
-    Wire.requestFrom(Rtcc_Addr, 5); //request 5 bytes
-    status1 = Wire.read();
-    hund_sec = Wire.read();
-    sec = bcdToDec(Wire.read());
-    minute = bcdToDec(Wire.read());
-    hour = bcdToDec(Wire.read());
+    RtccWire.requestFrom(RTCC_ADDR, 5); //request 5 bytes
+    status1 = RtccWire.read();
+    hund_sec = RtccWire.read();
+    sec = bcdToDec(RtccWire.read());
+    minute = bcdToDec(RtccWire.read());
+    hour = bcdToDec(RtccWire.read() & 0x3f);	//12h flags are not part of the hour
 }
 
+/*
+* Get status1, time and date with a single burst read,
+* same result as getTime() followed by getDate()
+*/
+void Rtc_Pcf8593::getDateTime()
+{
+    /* set the start byte , get the status1 byte */
+    RtccWire.beginTransmission(RTCC_ADDR);
+    RtccWire.write((byte)RTCC_STAT1_ADDR);
+    RtccWire.endTransmission();
+
+    RtccWire.requestFrom(RTCC_ADDR, 8); //request 8 bytes
+    status1 = RtccWire.read();
+    hund_sec = RtccWire.read();
+    sec = bcdToDec(RtccWire.read());
+    minute = bcdToDec(RtccWire.read());
+    hour = bcdToDec(RtccWire.read() & 0x3f);	//12h flags are not part of the hour
+    byte day_reg = RtccWire.read();
+    byte month_reg = RtccWire.read();
+    storeDate(day_reg, month_reg, RtccWire.read());
+}
+
+#if RTCC_FEATURE_FORMAT
 char *Rtc_Pcf8593::formatTime(byte style)
 {
     getTime();
+    return formatCachedTime(style);
+}
+
+/* format the last read time, no bus access */
+char *Rtc_Pcf8593::formatCachedTime(byte style)
+{
     switch (style) {
         case RTCC_TIME_HM:
             strOut[0] = '0' + (hour / 10);
@@ -482,7 +666,12 @@ char *Rtc_Pcf8593::formatTime(byte style)
 char *Rtc_Pcf8593::formatDate(byte style)
 {
     getDate();
+    return formatCachedDate(style);
+}
 
+/* format the last read date, no bus access */
+char *Rtc_Pcf8593::formatCachedDate(byte style)
+{
         switch (style) {
 
         case RTCC_DATE_ASIA:
@@ -532,6 +721,66 @@ char *Rtc_Pcf8593::formatDate(byte style)
     }
     return strDate;
 }
+#endif
+
+/* copy the last read time, no bus access */
+void Rtc_Pcf8593::getSnapshot(Rtcc_Time &t)
+{
+    t.hund_sec = bcdToDec(hund_sec);
+    t.second = sec;
+    t.minute = minute;
+    t.hour = hour;
+    t.day = day;
+    t.weekday = weekday;
+    t.month = month;
+    t.year = year;
+}
+
+/*
+* Seconds from one time to a later one, 0 if to is not later.
+* A to year below the from year is taken to be in the next century.
+*/
+unsigned long Rtc_Pcf8593::secondsBetween(const Rtcc_Time &from, const Rtcc_Time &to)
+{
+    byte to_year = to.year;
+    if (to_year < from.year){
+        to_year += 100;
+    }
+    long days = (long)dayNumber(to.day, to.month, to_year) - (long)dayNumber(from.day, from.month, from.year);
+    long secs = days * 86400L
+        + (to.hour * 60L + to.minute) * 60 + to.second
+        - ((from.hour * 60L + from.minute) * 60 + from.second);
+    if (secs < 0){
+        return 0;
+    }
+    return secs;
+}
+
+/* days in month, every 4th year from 2000 is a leap year */
+byte Rtc_Pcf8593::daysInMonth(byte month, byte year)
+{
+    switch (month) {
+        case 2:
+            return (year % 4 == 0) ? 29 : 28;
+        case 4:
+        case 6:
+        case 9:
+        case 11:
+            return 30;
+        default:
+            return 31;
+    }
+}
+
+/* days since 1.1.2000, year may go over 99 */
+unsigned long Rtc_Pcf8593::dayNumber(byte day, byte month, byte year)
+{
+    unsigned long days = year * 365UL + (year + 3) / 4;	//leap days before year
+    for (byte m = 1; m < month; m++) {
+        days += daysInMonth(m, year);
+    }
+    return days + day - 1;
+}
 
 byte Rtc_Pcf8593::getSecond() {
     return sec;
@@ -545,6 +794,7 @@ byte Rtc_Pcf8593::getHour() {
     return hour;
 }
 
+#if RTCC_FEATURE_ALARM
 byte Rtc_Pcf8593::getAlarmSecond() {
     return alarm_second;
 }
@@ -561,13 +811,23 @@ byte Rtc_Pcf8593::getAlarmDay() {
     return alarm_day;
 }
 
-byte Rtc_Pcf8593::getAlarmMonth() {
-    return alarm_month;
+/* the month register holds weekday bits in weekday mode, decoded by the current mode */
+byte Rtc_Pcf8593::getAlarmMonth()
+{
+    if ((status2 & 0x30) == RTCC_ALARM_WEEKDAY){
+        return 0;
+    }
+    return bcdToDec(alarm_month_reg & 0x1f);
 }
 
-byte Rtc_Pcf8593::getAlarmWeekday() {
-    return alarm_weekday;
+byte Rtc_Pcf8593::getAlarmWeekday()
+{
+    if ((status2 & 0x30) != RTCC_ALARM_WEEKDAY){
+        return 0;
+    }
+    return alarm_month_reg & 0x7f;
 }
+#endif
 
 byte Rtc_Pcf8593::getDay() {
     return day;
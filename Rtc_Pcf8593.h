@@ -41,6 +41,8 @@
 /* these are adjusted for arduino */
 #define RTCC_R 	0xa3
 #define RTCC_W 	0xa2
+/* 7 bit address used with Wire */
+#define RTCC_ADDR	(RTCC_R>>1)
 
 /* register addresses in the rtc */
 #define RTCC_STAT1_ADDR			0x0
@@ -84,14 +86,78 @@
 #define RTCC_TIME_HMS			0x01
 #define RTCC_TIME_HM			0x02
 
+/* build features, define any of these to 0 before the library is
+ * compiled (e.g. as a compiler flag) to leave that part out.
+ * RTCC_FEATURE_FORMAT  formatTime/formatDate and their string buffers
+ * RTCC_FEATURE_ALARM   alarm methods and alarm vars
+ * RTCC_FEATURE_CACHE   Rtc_Pcf8593_TimeService and Rtc_Pcf8593_Sampler
+ * RTCC_FEATURE_TRACE   Rtc_Pcf8593_Trace, off unless defined to 1
+ */
+#ifndef RTCC_FEATURE_FORMAT
+#define RTCC_FEATURE_FORMAT		1
+#endif
+#ifndef RTCC_FEATURE_ALARM
+#define RTCC_FEATURE_ALARM		1
+#endif
+#ifndef RTCC_FEATURE_CACHE
+#define RTCC_FEATURE_CACHE		1
+#endif
+#ifndef RTCC_FEATURE_TRACE
+#define RTCC_FEATURE_TRACE		0
+#endif
+
+/* define RTCC_PACKED_STATE to 1 to keep the local vars in bitfields,
+ * meant to save RAM for some flash and slower getters, not measured yet.
+ */
+#ifndef RTCC_PACKED_STATE
+#define RTCC_PACKED_STATE		0
+#endif
+#if RTCC_PACKED_STATE
+#define RTCC_BITS(n)	:n
+#else
+#define RTCC_BITS(n)
+#endif
+
+
+
 
+/* decoded time, see getSnapshot() */
+struct Rtcc_Time {
+	byte hund_sec;		/* 0-99 */
+	byte second;
+	byte minute;
+	byte hour;
+	byte day;
+	byte weekday;		/* 0-6, 0 = Sun for the weekday alarm */
+	byte month;
+	byte year;		/* 00-99, 20xx */
+};
 
+#if RTCC_FEATURE_ALARM
+/* decoded alarm, see getAlarmSnapshot() */
+struct Rtcc_Alarm {
+	byte mode;		/* RTCC_ALARM_DISABLED/DAILY/WEEKDAY/DATED */
+	byte second;
+	byte minute;
+	byte hour;
+	byte day;		/* dated */
+	byte month;		/* dated */
+	byte weekdays;		/* weekday, bit0 = Sun ... bit6 = Sat */
+};
+#endif
 
+#if RTCC_FEATURE_TRACE
+class Rtc_Pcf8593_Trace;
+#endif
 
 /* arduino class */
 class Rtc_Pcf8593 {
 	public:
 		Rtc_Pcf8593();
+#if RTCC_FEATURE_TRACE
+		/* record all bus transactions to trace, 0 to stop */
+		static void setTrace(Rtc_Pcf8593_Trace *trace);
+#endif
 
 		void initClock();	/* zero out all values, disable all alarms */
 		void clearStatus();	/* set both status bytes to zero */
@@ -99,10 +165,12 @@ class Rtc_Pcf8593 {
 		void getDate();		/* get date vals to local vars */
 		void setDate(byte day, byte weekday, byte month, byte century, byte year);
 		void getTime();    	/* get time vars + status1 byte to local vars */
+		void getDateTime();	/* getTime + getDate in one burst read */
 		//void getAlarm();
 		void setTime(byte sec, byte minute, byte hour);
 		byte readStatus1();	/* get status1 byte */
 		byte readStatus2();	/* get status2 byte */
+#if RTCC_FEATURE_ALARM
 		boolean alarmEnabled();
         	boolean alarmActive();
 
@@ -114,6 +182,13 @@ class Rtc_Pcf8593 {
 		void getAlarm();	/* get alarm vals to local vars */
 		void clearAlarm();	/* clear alarm flag and interrupt */
 		void resetAlarm();  	/* clear alarm flag but leave interrupt unchanged */
+		/* alarm vals, read from the chip only the first time */
+		void getAlarmSnapshot(Rtcc_Alarm &alarm);
+		/* next alarm after the last read time, false if none */
+		boolean nextAlarm(Rtcc_Time &next);
+		/* same from given vals, no bus access at all */
+		static boolean nextAlarm(const Rtcc_Time &now, const Rtcc_Alarm &alarm, Rtcc_Time &next);
+#endif
 
 		byte getSecond();
 		byte getMinute();
@@ -124,47 +199,66 @@ class Rtc_Pcf8593 {
 		byte getWeekday();
 		byte getStatus1();
 		byte getStatus2();
+		void getSnapshot(Rtcc_Time &t);	/* last read time vals */
+		static unsigned long secondsBetween(const Rtcc_Time &from, const Rtcc_Time &to);
 
+#if RTCC_FEATURE_ALARM
 		byte getAlarmSecond();
 		byte getAlarmMinute();
 		byte getAlarmHour();
 		byte getAlarmDay();
 		byte getAlarmMonth();
 		byte getAlarmWeekday();
+#endif
 
+#if RTCC_FEATURE_FORMAT
 		/*get a output string, these call getTime/getDate for latest vals */
 		char *formatTime(byte style=RTCC_TIME_HMS);
 		/* date supports 3 styles as listed in the wikipedia page about world date/time. */
 		char *formatDate(byte style=RTCC_DATE_US);
+		/* same output from the last read vals, no bus access */
+		char *formatCachedTime(byte style=RTCC_TIME_HMS);
+		char *formatCachedDate(byte style=RTCC_DATE_US);
+#endif
 
 	private:
 		/* methods */
 		byte decToBcd(byte value);
 		byte bcdToDec(byte value);
-		/* time variables */
-		byte hour;
-		byte minute;
-		byte sec;
-		byte hund_sec;
-		byte day;
-		byte weekday;
-		byte month;
-		byte year;
+		void storeDate(byte day_reg, byte month_reg, byte year_reg);
+		static byte daysInMonth(byte month, byte year);
+		static unsigned long dayNumber(byte day, byte month, byte year);
+#if RTCC_FEATURE_ALARM
+		static void addDay(Rtcc_Time &t);
+#endif
+		/* time variables, with RTCC_PACKED_STATE the widths below apply;
+		 * how the fields share bytes follows the bitfield rules of the
+		 * compiler, some let a field straddle two bytes, some do not */
+		byte hour RTCC_BITS(5);
+		byte weekday RTCC_BITS(3);
+		byte sec RTCC_BITS(6);
+		byte minute RTCC_BITS(6);
+		byte day RTCC_BITS(5);
+		byte month RTCC_BITS(4);
+		byte year RTCC_BITS(7);
+		byte hund_sec;		/* kept as read, bcd */
+#if RTCC_FEATURE_ALARM
 		/* alarm */
-		byte alarm_second;
-		byte alarm_minute;
-		byte alarm_hour;
-		byte alarm_weekday;
-		byte alarm_day;
-		byte alarm_month;
+		byte alarm_second RTCC_BITS(6);
+		byte alarm_minute RTCC_BITS(6);
+		byte alarm_hour RTCC_BITS(5);
+		byte alarm_day RTCC_BITS(5);
+		byte alarm_valid RTCC_BITS(1);	/* alarm vars match the chip */
+		byte alarm_month_reg;	/* as read, month or weekday bits by mode */
+#endif
 		/* support */
 		byte status1;
 		byte status2;
 
+#if RTCC_FEATURE_FORMAT
 		char strOut[9];
 		char strDate[11];
-
-		int Rtcc_Addr;
+#endif
 };
 
 #endif
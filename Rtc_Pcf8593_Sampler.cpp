@@ -0,0 +1,94 @@
+/*****
+ *  NAME
+ *    Background sampling of the Pcf8593 Real Time Clock
+ *  NOTES
+ *    See Rtc_Pcf8593_Sampler.h
+ ******
+ */
+
+#include "Arduino.h"
+#include "Rtc_Pcf8593.h"
+#include "Rtc_Pcf8593_Sampler.h"
+
+#if RTCC_FEATURE_CACHE
+
+Rtc_Pcf8593_Sampler::Rtc_Pcf8593_Sampler(Rtc_Pcf8593 &rtc, unsigned long period)
+    : rtc(rtc)
+{
+    this->period = period;
+    last_poll = 0;
+    due = true;			//first poll always samples
+    valid = false;
+    generation = 0;
+}
+
+void Rtc_Pcf8593_Sampler::tick()
+{
+    due = true;
+}
+
+boolean Rtc_Pcf8593_Sampler::poll()
+{
+    unsigned long now = millis();
+
+    if (!due && (period == 0 || now - last_poll < period)){
+        return false;
+    }
+    due = false;
+    last_poll = now;
+
+    Rtcc_Time t;
+    rtc.getDateTime();		//one burst read
+    rtc.getSnapshot(t);
+
+    /* fill the half not in use, readers keep using the other one */
+    byte next = (generation + 1) & 1;
+    snap[next].hund_sec = t.hund_sec;
+    snap[next].second = t.second;
+    snap[next].minute = t.minute;
+    snap[next].hour = t.hour;
+    snap[next].day = t.day;
+    snap[next].weekday = t.weekday;
+    snap[next].month = t.month;
+    snap[next].year = t.year;
+    snap_at[next] = now;
+
+    generation++;		//publish, a single byte write
+    valid = true;
+    return true;
+}
+
+boolean Rtc_Pcf8593_Sampler::read(Rtcc_Time &t)
+{
+    unsigned long sampled_at;
+    return read(t, sampled_at);
+}
+
+boolean Rtc_Pcf8593_Sampler::read(Rtcc_Time &t, unsigned long &sampled_at)
+{
+    byte g;
+
+    if (!valid){
+        return false;
+    }
+    do {
+        g = generation;
+        byte cur = g & 1;
+        t.hund_sec = snap[cur].hund_sec;
+        t.second = snap[cur].second;
+        t.minute = snap[cur].minute;
+        t.hour = snap[cur].hour;
+        t.day = snap[cur].day;
+        t.weekday = snap[cur].weekday;
+        t.month = snap[cur].month;
+        t.year = snap[cur].year;
+        sampled_at = snap_at[cur];
+    } while (g != generation);	//a new sample came in, copy again
+    return true;
+}
+
+byte Rtc_Pcf8593_Sampler::getGeneration() {
+    return generation;
+}
+
+#endif
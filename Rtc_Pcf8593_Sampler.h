@@ -0,0 +1,60 @@
+/*****
+ *  NAME
+ *    Background sampling of the Pcf8593 Real Time Clock
+ *  NOTES
+ *    Keeps a timestamp refreshed on a fixed cadence so readers never
+ *    wait for the bus.  Each sample is one Rtc_Pcf8593::getDateTime()
+ *    burst read into the free half of a double buffer, then the
+ *    generation counter is stepped, its low bit tells the half in use.
+ *    read() copies the half in use and tries again if the generation
+ *    changed meanwhile, so it is safe from any context, ISRs too, and
+ *    takes a few cycles.  That holds on single core parts, like all
+ *    AVR boards.
+ *
+ *    Wire can not be used from an ISR, so the bus read happens in
+ *    poll(), called from loop().  A sample is due every period ms
+ *    and/or when tick() was called.  The driver sets up no interrupt
+ *    source for this: the chip's timer holds the year and its alarm
+ *    fires at most once a day, so tick() has to come from the caller's
+ *    own timer or pin ISR.
+ *
+ *    Samples only refresh while loop() keeps calling poll().  A loop
+ *    blocked in delay() or a long task leaves readers with an old
+ *    sample, check the sample time from read() where that matters.
+ ******
+ */
+
+#ifndef Rtc_Pcf8593_Sampler_H
+#define Rtc_Pcf8593_Sampler_H
+
+#include "Arduino.h"
+#include "Rtc_Pcf8593.h"
+
+#if RTCC_FEATURE_CACHE
+class Rtc_Pcf8593_Sampler {
+	public:
+		/* period in ms, 0 to sample only on tick() */
+		Rtc_Pcf8593_Sampler(Rtc_Pcf8593 &rtc, unsigned long period);
+
+		void tick();		/* a sample is due, ISR safe */
+		boolean poll();		/* sample if due, true if the bus was read */
+
+		/* latest sample and the millis() it was taken at,
+		 * any context, false before the first sample */
+		boolean read(Rtcc_Time &t);
+		boolean read(Rtcc_Time &t, unsigned long &sampled_at);
+		byte getGeneration();	/* steps with every sample */
+
+	private:
+		Rtc_Pcf8593 &rtc;
+		unsigned long period;
+		unsigned long last_poll;
+		volatile boolean due;
+		volatile boolean valid;
+		volatile byte generation;
+		volatile Rtcc_Time snap[2];
+		volatile unsigned long snap_at[2];
+};
+#endif
+
+#endif
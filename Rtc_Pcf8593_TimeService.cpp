@@ -0,0 +1,92 @@
+/*****
+ *  NAME
+ *    Shared time service for the Pcf8593 Real Time Clock
+ *  NOTES
+ *    See Rtc_Pcf8593_TimeService.h
+ ******
+ */
+
+#include "Arduino.h"
+#include "Rtc_Pcf8593.h"
+#include "Rtc_Pcf8593_TimeService.h"
+
+#if RTCC_FEATURE_CACHE
+Rtc_Pcf8593_TimeService::Rtc_Pcf8593_TimeService(Rtc_Pcf8593 &rtc)
+    : rtc(rtc)
+{
+    read_at = 0;
+    valid = false;
+    hits = 0;
+    misses = 0;
+}
+
+boolean Rtc_Pcf8593_TimeService::refresh(unsigned long maxAge)
+{
+    unsigned long now = millis();
+
+    /* unsigned difference stays right over the millis() wrap */
+    if (valid && (now - read_at) <= maxAge){
+        hits++;
+        return false;
+    }
+
+    rtc.getDateTime();		//one burst read for time and date
+    read_at = now;
+    valid = true;
+    misses++;
+    return true;
+}
+
+void Rtc_Pcf8593_TimeService::invalidate()
+{
+    valid = false;
+}
+
+#if RTCC_FEATURE_FORMAT
+char *Rtc_Pcf8593_TimeService::formatTime(unsigned long maxAge, byte style)
+{
+    refresh(maxAge);
+    return rtc.formatCachedTime(style);
+}
+
+char *Rtc_Pcf8593_TimeService::formatDate(unsigned long maxAge, byte style)
+{
+    refresh(maxAge);
+    return rtc.formatCachedDate(style);
+}
+#endif
+
+Rtc_Pcf8593 &Rtc_Pcf8593_TimeService::clock() {
+    return rtc;
+}
+
+unsigned long Rtc_Pcf8593_TimeService::getAge() {
+    return millis() - read_at;
+}
+
+unsigned long Rtc_Pcf8593_TimeService::getHits() {
+    return hits;
+}
+
+unsigned long Rtc_Pcf8593_TimeService::getMisses() {
+    return misses;
+}
+
+byte Rtc_Pcf8593_TimeService::getHitRatio()
+{
+    unsigned long total = hits + misses;
+    if (total == 0){
+        return 0;
+    }
+    if (total > 0xFFFFFFFFUL / 100){	//hits * 100 would overflow
+        return (byte)(hits / (total / 100));
+    }
+    return (byte)(hits * 100 / total);
+}
+
+void Rtc_Pcf8593_TimeService::resetStats()
+{
+    hits = 0;
+    misses = 0;
+}
+#endif
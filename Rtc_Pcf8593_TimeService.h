@@ -0,0 +1,55 @@
+/*****
+ *  NAME
+ *    Shared time service for the Pcf8593 Real Time Clock
+ *  NOTES
+ *    Several modules reading the clock on their own end up doing the
+ *    same I2C reads within the same millisecond.  The service keeps one
+ *    snapshot, read with Rtc_Pcf8593::getDateTime(), and every reader
+ *    passes how old (in ms) a snapshot it still accepts.  Readers inside
+ *    that window share the snapshot, others trigger a new burst read.
+ *    Hits and misses are counted so the windows can be tuned.
+ ******
+ */
+
+#ifndef Rtc_Pcf8593_TimeService_H
+#define Rtc_Pcf8593_TimeService_H
+
+#include "Arduino.h"
+#include "Rtc_Pcf8593.h"
+
+#if RTCC_FEATURE_CACHE
+class Rtc_Pcf8593_TimeService {
+	public:
+		Rtc_Pcf8593_TimeService(Rtc_Pcf8593 &rtc);
+
+		/* read the clock unless the snapshot is at most maxAge ms old,
+		 * returns true if the bus was read */
+		boolean refresh(unsigned long maxAge);
+		void invalidate();	/* next refresh always reads the bus */
+
+		/* refresh(maxAge) and format the snapshot */
+#if RTCC_FEATURE_FORMAT
+		char *formatTime(unsigned long maxAge, byte style=RTCC_TIME_HMS);
+		char *formatDate(unsigned long maxAge, byte style=RTCC_DATE_US);
+#endif
+
+		/* the underlying clock, getters return the snapshot vals */
+		Rtc_Pcf8593 &clock();
+		unsigned long getAge();	/* ms since the snapshot was read */
+
+		/* statistics */
+		unsigned long getHits();
+		unsigned long getMisses();
+		byte getHitRatio();	/* hits in percent of all refreshes */
+		void resetStats();
+
+	private:
+		Rtc_Pcf8593 &rtc;
+		unsigned long read_at;	/* millis() of the last bus read */
+		boolean valid;
+		unsigned long hits;
+		unsigned long misses;
+};
+#endif
+
+#endif
@@ -0,0 +1,190 @@
+/*****
+ *  NAME
+ *    Bus transaction trace for the Pcf8593 Real Time Clock
+ *  NOTES
+ *    See Rtc_Pcf8593_Trace.h
+ ******
+ */
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "Rtc_Pcf8593.h"
+#include "Rtc_Pcf8593_Trace.h"
+
+#if RTCC_FEATURE_TRACE
+
+Rtc_Pcf8593_TraceWire RtccWire;
+
+Rtc_Pcf8593_Trace::Rtc_Pcf8593_Trace(byte *buf, unsigned int size)
+{
+    this->buf = buf;
+    this->size = size;
+    dropped = 0;
+    clear();
+}
+
+void Rtc_Pcf8593_Trace::clear()
+{
+    head = 0;
+    tail = 0;
+    used = 0;
+    count = 0;
+}
+
+void Rtc_Pcf8593_Trace::put(byte value)
+{
+    buf[head] = value;
+    head = (head + 1) % size;
+}
+
+/*
+* Add a record, dropping the oldest ones to make room
+*/
+void Rtc_Pcf8593_Trace::record(byte flags, byte addr, byte reg, byte status,
+                               unsigned long start, unsigned long duration, const byte *data)
+{
+    byte len = flags & 0x7f;
+    unsigned int needed = RTCC_TRACE_HEADER + len;
+
+    if (needed > size){		//never fits
+        dropped++;
+        return;
+    }
+    while (size - used < needed){
+        unsigned int old = RTCC_TRACE_HEADER + (buf[tail] & 0x7f);
+        tail = (tail + old) % size;
+        used -= old;
+        count--;
+        dropped++;
+    }
+
+    if (duration > 0xffff){
+        duration = 0xffff;
+    }
+    put(flags);
+    put(addr);
+    put(reg);
+    put(status);
+    put(start);
+    put(start >> 8);
+    put(start >> 16);
+    put(start >> 24);
+    put(duration);
+    put(duration >> 8);
+    for (byte i = 0; i < len; i++) {
+        put(data[i]);
+    }
+    used += needed;
+    count++;
+}
+
+unsigned int Rtc_Pcf8593_Trace::getCount() {
+    return count;
+}
+
+unsigned long Rtc_Pcf8593_Trace::getDropped() {
+    return dropped;
+}
+
+void Rtc_Pcf8593_Trace::dump(Print &out)
+{
+    out.write('R');
+    out.write('T');
+    out.write('C');
+    out.write('T');
+    out.write((byte)RTCC_TRACE_VERSION);
+    out.write((byte)0);
+    out.write((byte)count);
+    out.write((byte)(count >> 8));
+    out.write((byte)dropped);
+    out.write((byte)(dropped >> 8));
+    out.write((byte)(dropped >> 16));
+    out.write((byte)(dropped >> 24));
+    for (unsigned int i = 0; i < used; i++) {
+        out.write(buf[(tail + i) % size]);
+    }
+}
+
+
+Rtc_Pcf8593_TraceWire::Rtc_Pcf8593_TraceWire()
+{
+    trace = 0;
+    pointer = 0;
+    len = 0;
+    pos = 0;
+}
+
+void Rtc_Pcf8593_TraceWire::setTrace(Rtc_Pcf8593_Trace *trace)
+{
+    this->trace = trace;
+}
+
+void Rtc_Pcf8593_TraceWire::begin()
+{
+    Wire.begin();
+}
+
+void Rtc_Pcf8593_TraceWire::beginTransmission(int addr)
+{
+    start = micros();
+    this->addr = addr;
+    len = 0;
+    Wire.beginTransmission(addr);
+}
+
+size_t Rtc_Pcf8593_TraceWire::write(byte value)
+{
+    if (len < sizeof(data)){		//register + RTCC_TRACE_DATA bytes
+        data[len++] = value;
+    }
+    return Wire.write(value);
+}
+
+byte Rtc_Pcf8593_TraceWire::endTransmission()
+{
+    byte status = Wire.endTransmission();
+    unsigned long duration = micros() - start;
+
+    if (len == 0){
+        if (trace){
+            trace->record(0, addr, pointer, status, start, duration, data);
+        }
+        return status;
+    }
+    if (trace){
+        trace->record(len - 1, addr, data[0], status, start, duration, data + 1);
+    }
+    if (status == 0){
+        pointer = (data[0] + len - 1) & RTCC_TRACE_REG_MASK;	//chip increments after each byte
+    }
+    return status;
+}
+
+byte Rtc_Pcf8593_TraceWire::requestFrom(int addr, int quantity)
+{
+    start = micros();
+    byte got = Wire.requestFrom(addr, quantity);
+
+    /* keep the bytes for the record, read() hands them out */
+    len = 0;
+    pos = 0;
+    while (len < RTCC_TRACE_DATA && Wire.available()) {
+        data[len++] = Wire.read();
+    }
+    if (trace){
+        trace->record(RTCC_TRACE_READ | len, addr, pointer,
+                      got < quantity ? quantity - got : 0, start, micros() - start, data);
+    }
+    pointer = (pointer + got) & RTCC_TRACE_REG_MASK;
+    return got;
+}
+
+int Rtc_Pcf8593_TraceWire::read()
+{
+    if (pos < len){
+        return data[pos++];
+    }
+    return Wire.read();
+}
+
+#endif
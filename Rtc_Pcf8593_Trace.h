@@ -0,0 +1,90 @@
+/*****
+ *  NAME
+ *    Bus transaction trace for the Pcf8593 Real Time Clock
+ *  NOTES
+ *    Built with RTCC_FEATURE_TRACE set to 1, the driver records every
+ *    I2C transaction it issues to the trace given to
+ *    Rtc_Pcf8593::setTrace().  Records go to a ring buffer owned by
+ *    the sketch, the oldest are dropped when it is full.
+ *    dump() writes the trace in a binary format for
+ *    extras/trace_replay, all values little endian:
+ *
+ *    header  "RTCT", version (1), 0, record count (2), dropped (4)
+ *    record  flags      bit7 = read, bit0-6 = data length
+ *            address    7 bit i2c address
+ *            register   register pointer at the start
+ *            status     endTransmission() result for a write,
+ *                       bytes missing for a read
+ *            start      micros() at the start (4)
+ *            duration   micros (2), 0xffff if longer
+ *            data       length bytes, a write starts after the
+ *                       register byte
+ ******
+ */
+
+#ifndef Rtc_Pcf8593_Trace_H
+#define Rtc_Pcf8593_Trace_H
+
+#include "Arduino.h"
+#include "Rtc_Pcf8593.h"
+
+#if RTCC_FEATURE_TRACE
+
+#define RTCC_TRACE_VERSION		1
+#define RTCC_TRACE_HEADER		10	/* bytes before the data of a record */
+#define RTCC_TRACE_DATA			16	/* max data bytes in a record */
+#define RTCC_TRACE_READ			0x80
+#define RTCC_TRACE_REG_MASK		0x0f	/* the register pointer wraps 0x0f -> 0x00 */
+
+class Rtc_Pcf8593_Trace {
+	public:
+		/* buf is the ring buffer, size bytes */
+		Rtc_Pcf8593_Trace(byte *buf, unsigned int size);
+
+		void record(byte flags, byte addr, byte reg, byte status,
+			    unsigned long start, unsigned long duration, const byte *data);
+		void clear();
+		unsigned int getCount();	/* records in the buffer */
+		unsigned long getDropped();	/* records lost to a full buffer */
+		void dump(Print &out);	/* write the binary trace, oldest first */
+
+	private:
+		void put(byte value);
+		byte *buf;
+		unsigned int size;
+		unsigned int head;	/* next free byte */
+		unsigned int tail;	/* oldest record */
+		unsigned int used;
+		unsigned int count;
+		unsigned long dropped;
+};
+
+/* Wire as used by the driver, recording to the trace when one is set */
+class Rtc_Pcf8593_TraceWire {
+	public:
+		Rtc_Pcf8593_TraceWire();
+
+		void setTrace(Rtc_Pcf8593_Trace *trace);
+
+		void begin();
+		void beginTransmission(int addr);
+		size_t write(byte value);
+		byte endTransmission();
+		byte requestFrom(int addr, int quantity);
+		int read();
+
+	private:
+		Rtc_Pcf8593_Trace *trace;
+		unsigned long start;
+		byte addr;
+		byte pointer;		/* register pointer of the chip */
+		byte len;
+		byte pos;
+		byte data[RTCC_TRACE_DATA + 1];
+};
+
+extern Rtc_Pcf8593_TraceWire RtccWire;
+
+#endif
+
+#endif
@@ -0,0 +1,89 @@
+/* Demonstration of background sampling of the Rtc_Pcf8593 Clock.
+ *
+ * The clock is read every 100ms in loop(), a sensor interrupt on
+ * pin 2 stamps its events with the latest sample without touching
+ * the I2C bus.
+ * SCK - A5, SDA - A4, sensor data ready - D2/INT0
+ *
+ * After loading and starting the sketch, use the serial monitor
+ * to see the event stamps.
+ *
+ * setup:  see Pcf8593 data sheet.
+ *         1x 10Kohm pullup on Pin3 RESET
+ *         No pullups on Pin1 or Pin2 (I2C internals used)
+ *         1x 0.1pf on power
+ *         1x 32khz chrystal
+ */
+#include <Wire.h>
+#include <Rtc_Pcf8593.h>
+#include <Rtc_Pcf8593_Sampler.h>
+
+/* get a real time clock object */
+Rtc_Pcf8593 rtc;
+/* sample it every 100ms */
+Rtc_Pcf8593_Sampler sampler(rtc, 100);
+
+/* stamp of the last sensor event */
+volatile Rtcc_Time stamp;
+volatile int event_flag=0;
+
+/* the interrupt service routine, no bus access here */
+void sensor_ready()
+{
+  Rtcc_Time t;
+  if (sampler.read(t)){
+    stamp.hour = t.hour;
+    stamp.minute = t.minute;
+    stamp.second = t.second;
+    stamp.hund_sec = t.hund_sec;
+    event_flag=1;
+  }
+}
+
+void setup()
+{
+  pinMode(2, INPUT);           // set pin to input
+  digitalWrite(2, HIGH);       // turn on pullup resistors
+
+  Serial.begin(9600);
+
+  /* clear out all the registers */
+  rtc.initClock();
+  /* set a time to start with.
+   * day, weekday, month, century, year */
+  rtc.setDate(14, 6, 3, 0, 14);
+  /* hr, min, sec */
+  rtc.setTime(1, 15, 40);
+
+  /* setup int on pin 2 of arduino */
+  attachInterrupt(0, sensor_ready, FALLING);
+}
+
+void loop()
+{
+  /* the only place the clock is read */
+  sampler.poll();
+
+  if (event_flag==1){
+    noInterrupts();
+    byte hour = stamp.hour;
+    byte minute = stamp.minute;
+    byte second = stamp.second;
+    byte hund_sec = stamp.hund_sec;
+    event_flag=0;
+    interrupts();
+
+    Serial.print("event at ");
+    Serial.print(hour);
+    Serial.print(":");
+    Serial.print(minute);
+    Serial.print(":");
+    Serial.print(second);
+    Serial.print(".");
+    if (hund_sec < 10){
+      Serial.print("0");
+    }
+    Serial.print(hund_sec);
+    Serial.print("\r\n");
+  }
+}
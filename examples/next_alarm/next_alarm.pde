@@ -0,0 +1,63 @@
+/* Demonstration of predicting the next Rtc_Pcf8593 alarm.
+ *
+ * The alarm is read from the chip once, after that the next alarm
+ * time is worked out from the last read time without any I2C.
+ * A power manager can use the seconds to the alarm to pick
+ * how long to sleep.
+ * SCK - A5, SDA - A4, INT - D3/INT1
+ *
+ * After loading and starting the sketch, use the serial monitor
+ * to see the clock output.
+ *
+ * setup:  see Pcf8593 data sheet.
+ *         1x 10Kohm pullup on Pin3 RESET
+ *         No pullups on Pin1 or Pin2 (I2C internals used)
+ *         1x 0.1pf on power
+ *         1x 32khz chrystal
+ */
+#include <Wire.h>
+#include <Rtc_Pcf8593.h>
+
+/* get a real time clock object */
+Rtc_Pcf8593 rtc;
+
+void setup()
+{
+  Serial.begin(9600);
+
+  /* clear out all the registers */
+  rtc.initClock();
+  /* set a time to start with.
+   * day, weekday, month, century, year */
+  rtc.setDate(14, 5, 3, 0, 14);
+  /* hr, min, sec */
+  rtc.setTime(1, 15, 40);
+  /* alarm on Mondays and Fridays at 01:16:00 */
+  rtc.setAlarmTime(1, 16, 00);
+  rtc.setAlarmWeekday(B00100010);
+  rtc.setAlarmMode(RTCC_ALARM_WEEKDAY);
+}
+
+void loop()
+{
+  Rtcc_Time now;
+  Rtcc_Time next;
+
+  /* one read for the time, the alarm comes from the local vars */
+  rtc.getDateTime();
+  rtc.getSnapshot(now);
+  Serial.print(rtc.formatCachedTime());
+  Serial.print("  ");
+  Serial.print(rtc.formatCachedDate(RTCC_DATE_WORLD));
+
+  if (rtc.nextAlarm(next)){
+    Serial.print("  next alarm in ");
+    Serial.print(Rtc_Pcf8593::secondsBetween(now, next));
+    Serial.print(" s, weekday ");
+    Serial.print(next.weekday);
+  }else{
+    Serial.print("  no alarm");
+  }
+  Serial.print("\r\n");
+  delay(1000);
+}
@@ -0,0 +1,74 @@
+/* Demonstration of a shared Rtc_Pcf8593 time service.
+ *
+ * A logger, a display and a scheduler all want the time.  Instead of
+ * each of them reading the clock, they ask the service with how old
+ * a reading they still accept and share one I2C read.
+ * SCK - A5, SDA - A4
+ *
+ * After loading and starting the sketch, use the serial monitor
+ * to see the clock output and the hit ratio of the service.
+ *
+ * setup:  see Pcf8593 data sheet.
+ *         1x 10Kohm pullup on Pin3 RESET
+ *         No pullups on Pin1 or Pin2 (I2C internals used)
+ *         1x 0.1pf on power
+ *         1x 32khz chrystal
+ */
+#include <Wire.h>
+#include <Rtc_Pcf8593.h>
+#include <Rtc_Pcf8593_TimeService.h>
+
+/* get a real time clock object */
+Rtc_Pcf8593 rtc;
+/* and share it */
+Rtc_Pcf8593_TimeService clock_service(rtc);
+
+void setup()
+{
+  Serial.begin(9600);
+
+  /* clear out all the registers */
+  rtc.initClock();
+  /* set a time to start with.
+   * day, weekday, month, century, year */
+  rtc.setDate(14, 6, 3, 0, 14);
+  /* hr, min, sec */
+  rtc.setTime(1, 15, 40);
+}
+
+/* the logger wants a fresh time, at most 10ms old */
+void logger()
+{
+  Serial.print(clock_service.formatTime(10));
+  Serial.print("  ");
+  Serial.print(clock_service.formatDate(10, RTCC_DATE_WORLD));
+}
+
+/* the display only shows minutes, 500ms is fine */
+void display()
+{
+  Serial.print("  ");
+  Serial.print(clock_service.formatTime(500, RTCC_TIME_HM));
+}
+
+/* the scheduler runs jobs on the hour */
+void scheduler()
+{
+  clock_service.refresh(100);
+  if (clock_service.clock().getMinute() == 0 &&
+      clock_service.clock().getSecond() == 0){
+    Serial.print("  job!");
+  }
+}
+
+void loop()
+{
+  logger();
+  display();
+  scheduler();
+
+  Serial.print("  hits ");
+  Serial.print(clock_service.getHitRatio());
+  Serial.print("%\r\n");
+  delay(1000);
+}
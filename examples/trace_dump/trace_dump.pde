@@ -0,0 +1,56 @@
+/* Demonstration of the Rtc_Pcf8593 bus trace.
+ *
+ * Needs the library built with RTCC_FEATURE_TRACE=1 as a compiler flag.
+ * Every I2C transaction of the driver is recorded, send 'd' on the
+ * serial port to get the trace in binary, e.g. on linux
+ *   stty -F /dev/ttyUSB0 9600 raw; cat /dev/ttyUSB0 > trace.bin
+ * and look at it with extras/trace_replay.
+ * SCK - A5, SDA - A4
+ *
+ * setup:  see Pcf8593 data sheet.
+ *         1x 10Kohm pullup on Pin3 RESET
+ *         No pullups on Pin1 or Pin2 (I2C internals used)
+ *         1x 0.1pf on power
+ *         1x 32khz chrystal
+ */
+#include <Wire.h>
+#include <Rtc_Pcf8593.h>
+#include <Rtc_Pcf8593_Trace.h>
+
+#if !RTCC_FEATURE_TRACE
+#error "build with RTCC_FEATURE_TRACE=1"
+#endif
+
+/* get a real time clock object */
+Rtc_Pcf8593 rtc;
+
+/* keeps the last 7 or so loops, 6 transactions each */
+byte trace_buf[512];
+Rtc_Pcf8593_Trace trace(trace_buf, sizeof(trace_buf));
+
+void setup()
+{
+  Serial.begin(9600);
+
+  Rtc_Pcf8593::setTrace(&trace);
+  /* clear out all the registers */
+  rtc.initClock();
+  /* set a time to start with.
+   * day, weekday, month, century, year */
+  rtc.setDate(14, 6, 3, 0, 14);
+  /* hr, min, sec */
+  rtc.setTime(1, 15, 40);
+}
+
+void loop()
+{
+  /* the workload, nothing is printed to keep the port binary */
+  rtc.formatTime();
+  rtc.formatDate();
+
+  if (Serial.available() && Serial.read() == 'd'){
+    trace.dump(Serial);
+    trace.clear();
+  }
+  delay(1000);
+}
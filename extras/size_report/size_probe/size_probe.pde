@@ -0,0 +1,55 @@
+/* Size probe for the Rtc_Pcf8593 build features.
+ *
+ * Not a demo, compiled by size_report.sh once per feature set
+ * to see what each set costs in flash and RAM.
+ * With SIZE_PROBE_EMPTY it leaves the clock out to give the baseline.
+ */
+#include <Wire.h>
+#include <Rtc_Pcf8593.h>
+#include <Rtc_Pcf8593_TimeService.h>
+
+#ifndef SIZE_PROBE_EMPTY
+Rtc_Pcf8593 rtc;
+#if RTCC_FEATURE_CACHE
+Rtc_Pcf8593_TimeService clock_service(rtc);
+#endif
+#endif
+
+void setup()
+{
+  Serial.begin(9600);
+#ifndef SIZE_PROBE_EMPTY
+  rtc.initClock();
+  rtc.setDate(14, 6, 3, 0, 14);
+  rtc.setTime(1, 15, 40);
+#if RTCC_FEATURE_ALARM
+  rtc.setAlarmTime(1, 16, 00);
+  rtc.setAlarmMode(RTCC_ALARM_DAILY);
+#endif
+#endif
+}
+
+void loop()
+{
+#ifndef SIZE_PROBE_EMPTY
+#if RTCC_FEATURE_CACHE
+  clock_service.refresh(100);
+#else
+  rtc.getDateTime();
+#endif
+#if RTCC_FEATURE_FORMAT
+  Serial.print(rtc.formatCachedTime());
+  Serial.print(rtc.formatCachedDate());
+#else
+  Serial.print(rtc.getHour());
+  Serial.print(rtc.getMinute());
+  Serial.print(rtc.getSecond());
+#endif
+#if RTCC_FEATURE_ALARM
+  if (rtc.alarmActive()){
+    rtc.resetAlarm();
+  }
+#endif
+#endif
+  delay(1000);
+}
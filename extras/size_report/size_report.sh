@@ -0,0 +1,52 @@
+#!/bin/sh
+#
+# Print the flash/RAM cost of each Rtc_Pcf8593 build feature set.
+#
+# Cross-compiles size_probe with arduino-cli once per feature set and
+# prints the sizes and the difference to a sketch without the clock.
+# Needs arduino-cli with the core of the board installed.
+#
+#   FQBN=arduino:avr:pro ./size_report.sh
+#
+FQBN=${FQBN:-arduino:avr:uno}
+HERE=$(cd "$(dirname "$0")" && pwd)
+LIB=$(cd "$HERE/../.." && pwd)
+SKETCH="$HERE/size_probe"
+
+compile() {
+    arduino-cli compile --fqbn "$FQBN" --library "$LIB" --clean \
+        --build-property "compiler.cpp.extra_flags=$1" "$SKETCH" 2>&1
+}
+
+# prints "flash ram" of a compile output
+sizes() {
+    flash=$(echo "$1" | sed -n 's/^Sketch uses \([0-9]*\) bytes.*/\1/p')
+    ram=$(echo "$1" | sed -n 's/^Global variables use \([0-9]*\) bytes.*/\1/p')
+    if [ -z "$flash" ] || [ -z "$ram" ]; then
+        echo "$1" >&2
+        exit 1
+    fi
+    echo "$flash $ram"
+}
+
+base=$(sizes "$(compile -DSIZE_PROBE_EMPTY)") || exit 1
+base_flash=${base% *}
+base_ram=${base#* }
+
+echo "board $FQBN, baseline without clock: flash $base_flash, ram $base_ram"
+printf "%-10s %8s %8s %8s %8s\n" "config" "flash" "ram" "+flash" "+ram"
+
+report() {
+    s=$(sizes "$(compile "$2")") || exit 1
+    flash=${s% *}
+    ram=${s#* }
+    printf "%-10s %8d %8d %8d %8d\n" "$1" "$flash" "$ram" \
+        $((flash - base_flash)) $((ram - base_ram))
+}
+
+report full ""
+report packed "-DRTCC_PACKED_STATE=1"
+report noformat "-DRTCC_FEATURE_FORMAT=0"
+report noalarm "-DRTCC_FEATURE_ALARM=0"
+report nocache "-DRTCC_FEATURE_CACHE=0"
+report minimal "-DRTCC_FEATURE_FORMAT=0 -DRTCC_FEATURE_ALARM=0 -DRTCC_FEATURE_CACHE=0 -DRTCC_PACKED_STATE=1"
@@ -0,0 +1,439 @@
+/*****
+ *  NAME
+ *    trace_replay - replay Rtc_Pcf8593 bus traces against a simulated chip
+ *  NOTES
+ *    Reads traces written by Rtc_Pcf8593_Trace::dump(), format in
+ *    Rtc_Pcf8593_Trace.h.  Writes are applied to a simulated Pcf8593,
+ *    reads are checked against it and the bus use is summed up.
+ *    Given several traces of the same workload, e.g. from two driver
+ *    versions, it prints them side by side.
+ *
+ *    The simulated clock counts time regs 0x01-0x04 from the trace
+ *    timestamps, the date is not rolled over midnight.  Field traces
+ *    have usually lost their start to the ring buffer, so a register
+ *    not yet written in the trace takes its value from the first read
+ *    of it, the clock from the first read of all of 0x01-0x04, and is
+ *    compared from then on.  The alarm flag is not compared, the chip
+ *    sets that on its own.  A trace where nothing could be compared
+ *    fails.
+ *
+ *    build on linux:
+ *      g++ -O2 -o trace_replay trace_replay.cpp
+ *    usage:
+ *      trace_replay [-v] [-k khz] trace.bin [trace.bin ...]
+ ******
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#define TRACE_HEADER		10
+#define TRACE_READ		0x80
+#define TIME_FIRST		0x01	/* hundredths */
+#define TIME_LAST		0x04	/* hours */
+#define HUNDREDTHS_PER_DAY	8640000UL
+#define WINDOW_US		100000UL	/* busiest window length */
+#define ALARM_FLAG		0x02	/* status1 */
+#define REGS			16	/* the pointer wraps 0x0f -> 0x00 */
+#define REG(reg)		((reg) & (REGS - 1))
+
+struct Record {
+	bool read;
+	uint8_t addr;
+	uint8_t reg;
+	uint8_t status;
+	uint32_t start;
+	uint16_t duration;
+	std::vector<uint8_t> data;
+};
+
+struct Trace {
+	std::string name;
+	unsigned int count;
+	unsigned long dropped;
+	std::vector<Record> records;
+};
+
+struct Summary {
+	unsigned long writes;
+	unsigned long reads;
+	unsigned long bytes;		/* on the wire, address bytes included */
+	unsigned long bus_us;		/* measured, sum of durations */
+	unsigned long wire_us;		/* bit time at the given clock */
+	unsigned long span_us;
+	unsigned long busiest_us;	/* most bus time within WINDOW_US */
+	unsigned long errors;		/* nack or short read */
+	unsigned long mismatches;	/* read back differs from the simulation */
+	unsigned long max_drift;	/* hundredths, simulated vs read clock */
+	unsigned long compared;		/* bytes checked, clock regs not counted */
+	unsigned long clock_reads;	/* full clock reads checked for drift */
+	unsigned long learned;		/* bytes taken from reads as chip state */
+	unsigned long reg_reads[256];
+	unsigned long reg_writes[256];
+};
+
+static int bcd(int value) { return (value / 10) * 16 + value % 10; }
+static int dec(int value) { return (value >> 4) * 10 + (value & 0x0f); }
+
+/* Pcf8593 registers with an auto incrementing pointer and a running clock */
+class SimPcf8593 {
+	public:
+		SimPcf8593()
+		{
+			memset(regs, 0, sizeof(regs));
+			memset(known, 0, sizeof(known));
+			regs[0] = 0x04;
+			base_hund = 0;
+			base_us = 0;
+		}
+
+		void write(uint32_t at, uint8_t reg, const std::vector<uint8_t> &data)
+		{
+			tick(at);
+			for (size_t i = 0; i < data.size(); i++) {
+				regs[REG(reg + i)] = data[i];
+				known[REG(reg + i)] = true;
+			}
+			if (touches_time(reg, data.size())){
+				base_hund = clock_regs();
+				base_us = at;
+			}
+		}
+
+		void read(uint32_t at, uint8_t reg, size_t len, std::vector<uint8_t> &out)
+		{
+			tick(at);
+			out.resize(len);
+			for (size_t i = 0; i < len; i++) {
+				out[i] = regs[REG(reg + i)];
+			}
+		}
+
+		/* hundredths of the day in regs, as bcd */
+		static unsigned long hundredths(const uint8_t *time)
+		{
+			return ((dec(time[3] & 0x3f) * 60UL + dec(time[2] & 0x7f)) * 60
+				+ dec(time[1] & 0x7f)) * 100 + dec(time[0]);
+		}
+
+		bool is_known(uint8_t reg)
+		{
+			return known[REG(reg)];
+		}
+
+		bool clock_known()
+		{
+			for (int reg = TIME_FIRST; reg <= TIME_LAST; reg++) {
+				if (!known[reg]){
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/* take a value read from the chip as the simulated state */
+		void learn(uint8_t reg, uint8_t value)
+		{
+			regs[REG(reg)] = value;
+			known[REG(reg)] = true;
+		}
+
+		/* start the simulated clock from a read of all time regs */
+		void learn_clock(uint32_t at, const uint8_t *time)
+		{
+			for (int reg = TIME_FIRST; reg <= TIME_LAST; reg++) {
+				learn(reg, time[reg - TIME_FIRST]);
+			}
+			base_hund = hundredths(time);
+			base_us = at;
+		}
+
+		static bool is_time(uint8_t reg)
+		{
+			return REG(reg) >= TIME_FIRST && REG(reg) <= TIME_LAST;
+		}
+
+		static bool touches_time(uint8_t reg, size_t len)
+		{
+			for (size_t i = 0; i < len && i < REGS; i++) {
+				if (is_time(reg + i)){
+					return true;
+				}
+			}
+			return false;
+		}
+
+	private:
+		unsigned long clock_regs()
+		{
+			return hundredths(regs + TIME_FIRST);
+		}
+
+		/* bring the time regs up to at */
+		void tick(uint32_t at)
+		{
+			unsigned long now = (base_hund + (uint32_t)(at - base_us) / 10000)
+				% HUNDREDTHS_PER_DAY;
+			regs[1] = bcd(now % 100);
+			regs[2] = bcd(now / 100 % 60);
+			regs[3] = bcd(now / 6000 % 60);
+			regs[4] = (regs[4] & 0xc0) | bcd(now / 360000);
+		}
+
+		uint8_t regs[REGS];
+		bool known[REGS];	/* written in the trace */
+		unsigned long base_hund;
+		uint32_t base_us;
+};
+
+static bool load(const char *path, Trace &trace)
+{
+	FILE *f = fopen(path, "rb");
+	if (!f){
+		perror(path);
+		return false;
+	}
+	std::vector<uint8_t> buf;
+	uint8_t chunk[4096];
+	size_t n;
+	while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+		buf.insert(buf.end(), chunk, chunk + n);
+	}
+	fclose(f);
+
+	if (buf.size() < 12 || memcmp(&buf[0], "RTCT", 4) != 0){
+		fprintf(stderr, "%s: not a trace\n", path);
+		return false;
+	}
+	if (buf[4] != 1){
+		fprintf(stderr, "%s: trace version %d not supported\n", path, buf[4]);
+		return false;
+	}
+	trace.name = path;
+	trace.count = buf[6] | buf[7] << 8;
+	trace.dropped = buf[8] | buf[9] << 8 | (unsigned long)buf[10] << 16
+		| (unsigned long)buf[11] << 24;
+
+	size_t pos = 12;
+	while (pos + TRACE_HEADER <= buf.size()) {
+		Record r;
+		const uint8_t *h = &buf[pos];
+		size_t len = h[0] & 0x7f;
+		r.read = h[0] & TRACE_READ;
+		r.addr = h[1];
+		r.reg = h[2];
+		r.status = h[3];
+		r.start = h[4] | h[5] << 8 | h[6] << 16 | (uint32_t)h[7] << 24;
+		r.duration = h[8] | h[9] << 8;
+		pos += TRACE_HEADER;
+		if (pos + len > buf.size()){
+			fprintf(stderr, "%s: truncated record %zu\n", path, trace.records.size());
+			return false;
+		}
+		r.data.assign(buf.begin() + pos, buf.begin() + pos + len);
+		pos += len;
+		trace.records.push_back(r);
+	}
+	if (trace.records.size() != trace.count){
+		fprintf(stderr, "%s: %zu records, header says %u\n", path,
+			trace.records.size(), trace.count);
+	}
+	return true;
+}
+
+static void print_record(const Record &r, const char *note)
+{
+	printf("  %10lu %5u us  %s 0x%02x reg 0x%02x", (unsigned long)r.start,
+	       r.duration, r.read ? "R" : "W", r.addr, r.reg);
+	for (size_t i = 0; i < r.data.size(); i++) {
+		printf(" %02x", r.data[i]);
+	}
+	if (r.status){
+		printf("  status %d", r.status);
+	}
+	printf("%s\n", note);
+}
+
+static void replay(const Trace &trace, unsigned int khz, bool verbose, Summary &s)
+{
+	SimPcf8593 chip;
+	std::vector<uint8_t> expect;
+
+	memset(&s, 0, sizeof(s));
+	if (verbose){
+		printf("%s\n", trace.name.c_str());
+	}
+	for (size_t i = 0; i < trace.records.size(); i++) {
+		const Record &r = trace.records[i];
+		/* address byte, register byte for a write, data, 9 bits each */
+		unsigned long bytes = 1 + (r.read ? 0 : 1) + r.data.size();
+		const char *note = "";
+
+		s.bytes += bytes;
+		s.bus_us += r.duration;
+		s.wire_us += ((bytes * 9 + 2) * 1000 + khz - 1) / khz;
+		if (r.status){
+			s.errors++;
+		}
+
+		if (r.read){
+			s.reads++;
+			s.reg_reads[r.reg]++;
+			chip.read(r.start, r.reg, r.data.size(), expect);
+			/* the clock is compared only when all of it was read */
+			uint8_t got[TIME_LAST - TIME_FIRST + 1];
+			uint8_t sim[TIME_LAST - TIME_FIRST + 1];
+			unsigned int clock_regs = 0;
+			for (size_t b = 0; b < r.data.size(); b++) {
+				uint8_t reg = REG(r.reg + b);
+				uint8_t mask = reg == 0 ? ~ALARM_FLAG : 0xff;
+				if (SimPcf8593::is_time(reg)){
+					got[reg - TIME_FIRST] = r.data[b];
+					sim[reg - TIME_FIRST] = expect[b];
+					clock_regs |= 1 << (reg - TIME_FIRST);
+					continue;
+				}
+				if (!chip.is_known(reg)){	//state from before the trace
+					chip.learn(reg, r.data[b]);
+					s.learned++;
+					continue;
+				}
+				s.compared++;
+				if ((expect[b] & mask) != (r.data[b] & mask)){
+					s.mismatches++;
+					note = "  <- differs from simulation";
+				}
+			}
+			if (clock_regs != (1 << (TIME_LAST - TIME_FIRST + 1)) - 1){
+				//part of the clock, nothing to check it against
+			} else if (!chip.clock_known()){
+				chip.learn_clock(r.start, got);
+				s.learned += TIME_LAST - TIME_FIRST + 1;
+			} else {
+				s.clock_reads++;
+				long drift = (long)SimPcf8593::hundredths(got)
+					- (long)SimPcf8593::hundredths(sim);
+				if ((unsigned long)labs(drift) > s.max_drift){
+					s.max_drift = labs(drift);
+				}
+			}
+		} else {
+			s.writes++;
+			s.reg_writes[r.reg]++;
+			if (r.status == 0){	//a nacked write changes nothing
+				chip.write(r.start, r.reg, r.data);
+			}
+		}
+		if (verbose){
+			print_record(r, note);
+		}
+	}
+
+	if (trace.records.empty()){
+		return;
+	}
+	const Record &first = trace.records.front();
+	const Record &last = trace.records.back();
+	s.span_us = (uint32_t)(last.start - first.start) + last.duration;
+
+	/* busiest window, records start in time order */
+	unsigned long window = 0;
+	size_t lo = 0;
+	for (size_t hi = 0; hi < trace.records.size(); hi++) {
+		window += trace.records[hi].duration;
+		while ((uint32_t)(trace.records[hi].start - trace.records[lo].start) >= WINDOW_US) {
+			window -= trace.records[lo].duration;
+			lo++;
+		}
+		if (window > s.busiest_us){
+			s.busiest_us = window;
+		}
+	}
+}
+
+static void print_summary(const Trace &trace, const Summary &s, unsigned int khz)
+{
+	printf("%s\n", trace.name.c_str());
+	printf("  records      %zu (%lu dropped on the device)\n",
+	       trace.records.size(), trace.dropped);
+	printf("  transactions %lu writes, %lu reads\n", s.writes, s.reads);
+	printf("  bytes        %lu\n", s.bytes);
+	printf("  bus time     %lu us measured, %lu us at %u kHz\n", s.bus_us, s.wire_us, khz);
+	printf("  span         %lu us, busiest %lu ms: %lu us on the bus\n",
+	       s.span_us, WINDOW_US / 1000, s.busiest_us);
+	printf("  errors       %lu\n", s.errors);
+	printf("  replay       %lu mismatches, clock drift %lu/100 s\n",
+	       s.mismatches, s.max_drift);
+	printf("  compared     %lu bytes, %lu clock reads, %lu bytes taken as chip state\n",
+	       s.compared, s.clock_reads, s.learned);
+	printf("  register     reads  writes\n");
+	for (int reg = 0; reg < 256; reg++) {
+		if (s.reg_reads[reg] || s.reg_writes[reg]){
+			printf("  0x%02x      %7lu %7lu\n", reg, s.reg_reads[reg], s.reg_writes[reg]);
+		}
+	}
+}
+
+static void usage()
+{
+	fprintf(stderr, "usage: trace_replay [-v] [-k khz] trace.bin [trace.bin ...]\n");
+	exit(2);
+}
+
+int main(int argc, char **argv)
+{
+	bool verbose = false;
+	unsigned int khz = 100;
+	std::vector<Trace> traces;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-v") == 0){
+			verbose = true;
+		} else if (strcmp(argv[i], "-k") == 0){
+			if (++i >= argc || (khz = atoi(argv[i])) == 0){
+				usage();
+			}
+		} else if (argv[i][0] == '-'){
+			usage();
+		} else {
+			Trace trace;
+			if (!load(argv[i], trace)){
+				return 1;
+			}
+			traces.push_back(trace);
+		}
+	}
+	if (traces.empty()){
+		usage();
+	}
+
+	std::vector<Summary> summaries(traces.size());
+	bool failed = false;
+	for (size_t i = 0; i < traces.size(); i++) {
+		replay(traces[i], khz, verbose, summaries[i]);
+		print_summary(traces[i], summaries[i], khz);
+		if (summaries[i].mismatches){
+			failed = true;
+		}
+		if (summaries[i].compared == 0 && summaries[i].clock_reads == 0){
+			fprintf(stderr, "%s: nothing compared, the replay checked nothing\n",
+				traces[i].name.c_str());
+			failed = true;
+		}
+	}
+
+	if (traces.size() > 1){
+		printf("\n%-24s %8s %8s %10s %10s %8s\n",
+		       "trace", "trans", "bytes", "bus us", "wire us", "errors");
+		for (size_t i = 0; i < traces.size(); i++) {
+			const Summary &s = summaries[i];
+			printf("%-24s %8lu %8lu %10lu %10lu %8lu\n", traces[i].name.c_str(),
+			       s.writes + s.reads, s.bytes, s.bus_us, s.wire_us, s.errors);
+		}
+	}
+	return failed ? 1 : 0;
+}